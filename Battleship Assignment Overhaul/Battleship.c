@@ -9,11 +9,20 @@ The player who sinks all of their enemy's ships wins the game. If the player wou
 STATUS: COMPLETE (for now, currently under revisions on github as of 01/26/2025).
 */
 /*-----------------------------------Included libraries-----------------------------------*/
+#define _POSIX_C_SOURCE 199309L // Needed for clock_gettime when compiling in strict C mode
 #include <stdio.h>  // Standard input/output library
 #include <stdlib.h> // Standard library
 #include <time.h>   // Time library for random number generation
 #include <string.h> // String library for memset
 #include <ctype.h>  // Character type library for isalpha and isdigit
+#include <errno.h>  // Error numbers for checking the --budget value
+#include <stdint.h> // Fixed width integer types for the random number generator state and cell bitmasks
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h> // SSE2 and AVX2 intrinsics for the heatmap kernels
+#define HEATMAP_X86 1
+#else
+#define HEATMAP_X86 0
+#endif
 #include "Battleship_vars.h" // Include the Battleship variable definitions
 #include "Battleship_funcs.h" // Include the Battleship function definitions
 /*-----------------------------------Clear Buffer Function-----------------------------------*/
@@ -39,6 +48,90 @@ printf("                                           Welcome to Liam's Battleship
 printf("=================================================================================================================\n");
 }
 
+/*-----------------------------------Random Number Functions-----------------------------------*/
+/*
+Purpose: Seed the game's random number generator. The game keeps its own generator (instead of rand) so that its state
+can be saved and restored along with the rest of the game.
+Parameters: uint32_t seed - the seed value.
+Return: None
+Side Effects: Modifies the global variable randomState.
+*/
+void seedRandom(uint32_t seed) {
+    randomState = seed ? seed : 1; // the generator gets stuck on 0, so never use it as a state
+}
+
+/*
+Purpose: Get the next random number from the game's xorshift generator.
+Parameters: None
+Return: A non-negative random integer.
+Side Effects: Modifies the global variable randomState.
+*/
+int gameRandom() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return (int)(randomState >> 1); // drop the top bit so the result always fits in a non-negative int
+}
+
+/*-----------------------------------Timer Functions-----------------------------------*/
+/*
+Purpose: Read a monotonic clock, used to keep the enemy within its time budget.
+Parameters: None
+Return: The current time in microseconds (only differences between two readings are meaningful).
+Side Effects: None
+*/
+long long currentMicroseconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/*
+Purpose: Record how long the enemy took to pick a move and whether it ran into its time budget.
+Parameters: long long startTime - the time (from currentMicroseconds) the enemy started picking the move.
+            int budgetHit - 1 if the move was cut short by the time budget, 0 otherwise.
+Return: None
+Side Effects: Modifies the global variables enemyMovesPlayed, enemyMovesOverBudget, and enemyThinkingMicroseconds.
+*/
+void recordEnemyMove(long long startTime, int budgetHit) {
+    enemyMovesPlayed++;
+    enemyMovesOverBudget += budgetHit;
+    enemyThinkingMicroseconds += currentMicroseconds() - startTime;
+}
+
+/*
+Purpose: Set how long the enemy may spend picking each move.
+Parameters: long long budgetMicroseconds - the time budget in microseconds (INTERACTIVE_MOVE_BUDGET_US for terminal play,
+            BATCH_MOVE_BUDGET_US for simulating games in bulk). Negative budgets are treated as 0.
+Return: None
+Side Effects: Modifies the global variable moveBudgetMicroseconds.
+*/
+void setMoveBudget(long long budgetMicroseconds) {
+    moveBudgetMicroseconds = budgetMicroseconds < 0 ? 0 : budgetMicroseconds;
+}
+
+/*
+Purpose: Read a move budget given on the command line. The value must be a whole number of microseconds made up of digits only
+(no sign, spaces, or units), so "abc", "5ms", "-5", and "" are all rejected.
+Parameters: const char* budgetText - the text to read.
+            long long* budgetMicroseconds - a pointer to store the budget in.
+Return: 1 if the budget is valid, 0 if it is invalid.
+Side Effects: Modifies the budgetMicroseconds parameter when the budget is valid.
+*/
+int parseMoveBudget(const char* budgetText, long long* budgetMicroseconds) {
+    char* endOfNumber = NULL;
+    if (!isdigit((unsigned char)budgetText[0])) { // strtoll would also take leading spaces and a sign
+        return 0;
+    }
+    errno = 0;
+    long long budget = strtoll(budgetText, &endOfNumber, 10);
+    if (errno == ERANGE || *endOfNumber != '\0') { // too large, or followed by something that is not a digit
+        return 0;
+    }
+    *budgetMicroseconds = budget;
+    return 1;
+}
+
 /*-----------------------------------Get Valid Input Function-----------------------------------*/
 /*
 Purpose: Get valid input from the user based on the provided validation function.
@@ -125,6 +218,32 @@ int isValidAgreement(const char* playerAgreement) {
     return (*playerAgreement == 'Y' || *playerAgreement == 'y' || *playerAgreement == 'N' || *playerAgreement == 'n');
 }
 
+/*-----------------------------------Get Game Mode-----------------------------------*/
+/*
+Purpose: Let the player pick between the Classic and Salvo game modes.
+Parameters: char* gameModeChoice - a pointer to a character array to store the player's choice.
+Return: None
+Side Effects: Modifies the global variable salvoMode based on the player's choice (C/S).
+*/
+void getGameMode(char* gameModeChoice) {
+    printf("\nThere are two ways to play:\n");
+    printf("C. Classic - each side fires one shot per turn.\n");
+    printf("S. Salvo - each side fires one shot for every ship it still has afloat, and the whole volley lands at once.\n");
+    getValidInput("Which mode would you like to play? (C/S): ", gameModeChoice, isValidGameMode);
+    salvoMode = (*gameModeChoice == 'S' || *gameModeChoice == 's');
+}
+
+/*-----------------------------------Game Mode Validation Function-----------------------------------*/
+/*
+Purpose: Check if the game mode entered by the player is valid. The game mode must be either 'C' or 'S'.
+Parameters: const char* gameModeChoice - a pointer to a character containing the player's choice.
+Return: 1 if the game mode is valid, 0 if the game mode is invalid.
+Side Effects: const char* gameModeChoice - returns the users choice (C/c or S/s)
+*/
+int isValidGameMode(const char* gameModeChoice) {
+    return (*gameModeChoice == 'C' || *gameModeChoice == 'c' || *gameModeChoice == 'S' || *gameModeChoice == 's');
+}
+
 /*-----------------------------------Initialization Function-----------------------------------*/
 /*
 Purpose: Initialize the game. The function will set all the grids to empty cells and reset the game statistics.
@@ -132,7 +251,7 @@ Parameters: None
 Return: None
 Side Effects: 
 Modifies the global variables playerGrid, enemyGrid, playerViewOfEnemyGrid, playerHits, playerMisses, playerSunkShips, 
-enemyHits, enemyMisses, enemySunkShips, lastHitXCoordinate, and lastHitYCoordinate via initialization.
+enemyHits, enemyMisses, enemySunkShips, playerShipsAnnounced, enemyShipsAnnounced, lastHitXCoordinate, lastHitYCoordinate, gameSaved, and the enemy move timing counters via initialization.
 */
 void initializeGame() {
     memset(playerGrid, EMPTY_CELL, sizeof(playerGrid)); // Initialize player grid
@@ -140,7 +259,12 @@ void initializeGame() {
     memset(playerViewOfEnemyGrid, EMPTY_CELL, sizeof(playerViewOfEnemyGrid)); // Initialize player's view of enemy grid
     playerHits = playerMisses = playerSunkShips = 0;
     enemyHits = enemyMisses = enemySunkShips = 0;
+    memset(playerShipsAnnounced, 0, sizeof(playerShipsAnnounced));
+    memset(enemyShipsAnnounced, 0, sizeof(enemyShipsAnnounced));
     lastHitXCoordinate = lastHitYCoordinate = GRID_SIZE; // Set to GRID_SIZE because it is out of valid range
+    gameSaved = 0;
+    enemyMovesPlayed = enemyMovesOverBudget = 0;
+    enemyThinkingMicroseconds = 0;
 }
 
 /*-----------------------------------Helper Functions-----------------------------------*/
@@ -164,6 +288,27 @@ int getValidCoordinate(const char* prompt) {
     return coordinate - 1; // Adjust for 0-based index
 }
 
+/*
+Purpose: Validate user input for an attack coordinate. Works like getValidCoordinate, but also accepts 0 so the player can save and quit.
+Parameters: const char* prompt - the prompt message to display.
+Return: The valid coordinate (0-based index), or SAVE_AND_QUIT if the player entered 0.
+Side Effects: const char* prompt - prints the prompt message to the user and modifies the state of the variable based on the users input.
+*/
+int getAttackCoordinate(const char* prompt) {
+    int coordinate = 0; // the coordinates for the player, initalized to 0
+    do {
+        printf("%s", prompt);
+        if (scanf("%d", &coordinate) != 1 || coordinate < 0 || coordinate > 10) {
+            printf("\nInvalid input. Please enter a number between 1 and 10 (or 0 to save and quit): ");
+            ClearBuffer();
+            coordinate = -1; // keep looping on bad input
+        } else {
+            break;
+        }
+    } while (coordinate < 0 || coordinate > 10);
+    return coordinate - 1; // Adjust for 0-based index (0 becomes SAVE_AND_QUIT)
+}
+
 /*
 Purpose: Handle the confirmation of ship placement by the player.
 Parameters: const char* shipName - the name of the ship.
@@ -261,9 +406,9 @@ void placeEnemyShips() {
     for (int shipIndex = 0; shipIndex < 4; shipIndex++) {
         int shipPlaced = 0;
         do {
-            shipOrientation = rand() % 2; // Randomly select orientation
-            xCoordinate = rand() % GRID_SIZE; // Randomly select x and y coordinates
-            yCoordinate = rand() % GRID_SIZE;
+            shipOrientation = gameRandom() % 2; // Randomly select orientation
+            xCoordinate = gameRandom() % GRID_SIZE; // Randomly select x and y coordinates
+            yCoordinate = gameRandom() % GRID_SIZE;
 
             if (DEBUG) { // Debug flag to print the enemy orientation for testing purposes
                 printf("\nEnemy orientation for %s: %c\n", shipNames[shipIndex], orientations[shipOrientation]);
@@ -287,23 +432,34 @@ void placeEnemyShips() {
 
 /*-----------------------------------Game Loop-----------------------------------*/
 /* 
-Purpose: Run the game loop. The game loop will continue until one of the players wins the game.
+Purpose: Run the game loop. The game loop will continue until one of the players wins the game or the player saves and quits.
 Parameters: None
 Return: None
-Side Effects: Calls playerTurn and enemyTurn functions, updates game state, and prints game status.
+Side Effects: Calls playerTurn and enemyTurn functions (or their salvo versions), updates game state, and prints game status.
 */
 void gameLoop() { 
     int gameWon = 0;
     while (gameWon == 0) {
-        playerTurn();
-        hitAndSunkShips(enemyGrid, &enemySunkShips);
+        if (salvoMode) {
+            playerSalvoTurn(); // the whole volley is resolved (and sunk ships counted) in one batch
+        } else {
+            playerTurn();
+            hitAndSunkShips(enemyGrid, &enemySunkShips, enemyShipsAnnounced, 0);
+        }
+        if (gameSaved) { // the player saved the game and asked to quit
+            break;
+        }
         if (enemySunkShips == 4) {
             printf("\nCongratulations! You won!\n");
             gameWon = 1;
             break;
         }
-        enemyTurn();
-        hitAndSunkShips(playerGrid, &playerSunkShips);
+        if (salvoMode) {
+            enemySalvoTurn(); // the whole volley is resolved (and sunk ships counted) in one batch
+        } else {
+            enemyTurn();
+            hitAndSunkShips(playerGrid, &playerSunkShips, playerShipsAnnounced, 1);
+        }
         if (playerSunkShips == 4) {
             printf("\nThe enemy has won. Better luck next time!\n");
             gameWon = 1;
@@ -336,7 +492,11 @@ void printBoard(char grid[GRID_SIZE][GRID_SIZE], const char* boardTitle) {
     for (int rowIndex = 0; rowIndex < GRID_SIZE; rowIndex++) { // for each row
         printf("%2d |", rowIndex + 1); // Print the row number
         for (int colIndex = 0; colIndex < GRID_SIZE; colIndex++) { // for each column
-            printf("%2c ", grid[rowIndex][colIndex]); // Print the cell value
+            if (grid[rowIndex][colIndex] >= '2' + 10 && grid[rowIndex][colIndex] <= '5' + 10) { // if the cell is a ship cell that has been hit (ship length + 10),
+                printf("%2c ", HIT_CELL);                                                        // print it as a hit
+            } else {
+                printf("%2c ", grid[rowIndex][colIndex]); // Print the cell value
+            }
         }
         printf("|\n"); // Print a newline
     }
@@ -394,13 +554,19 @@ void printEnemyBoard(char grid[GRID_SIZE][GRID_SIZE], const char* boardTitle) {
 Purpose: Allow the player to take their turn in the game. The player will be prompted to enter the x and y coordinates to attack.
 Parameters: None
 Return: None
-Side Effects: Modifies the global variables playerHits, playerMisses, enemyGrid, and playerViewOfEnemyGrid.
+Side Effects: Modifies the global variables playerHits, playerMisses, enemyGrid, playerViewOfEnemyGrid, and gameSaved.
 */
 void playerTurn() {
     int xCoordinate = 0;
     int yCoordinate = 0;
     printf("\nYour turn.\n");
-    xCoordinate = getValidCoordinate("Enter X coordinate to attack (1-10): ");
+    xCoordinate = getAttackCoordinate("Enter X coordinate to attack (1-10, 0 to save and quit): ");
+    while (xCoordinate == SAVE_AND_QUIT) { // if the player wants to stop here, park the game
+        if (saveGameAndQuit()) {
+            return;
+        }
+        xCoordinate = getAttackCoordinate("Enter X coordinate to attack (1-10, 0 to save and quit): ");
+    }
     yCoordinate = getValidCoordinate("Enter Y coordinate to attack (1-10): ");
 
     if (!isValidCoordinate(xCoordinate, yCoordinate)) {
@@ -427,7 +593,7 @@ void playerTurn() {
         if (DEBUG) { // note: add 10 here
             printf("Marked enemy grid at (%d, %d) as HIT_CELL\n", xCoordinate, yCoordinate);
         }
-        hitAndSunkShips(enemyGrid, &enemySunkShips); // Pass the address of enemySunkShips to update it correctly
+        hitAndSunkShips(enemyGrid, &enemySunkShips, enemyShipsAnnounced, 0); // Pass the address of enemySunkShips to update it correctly
     } else {
         printf("MISS!\n");
         playerMisses++;
@@ -449,53 +615,46 @@ void playerTurn() {
 
 /*-----------------------------------Enemy Turn function-----------------------------------*/
 /*
-Purpose: Allow the enemy to take its turn in the game. The enemy will randomly select coordinates to attack.
+Purpose: Allow the enemy to take its turn in the game. After a hit the enemy aims at the unshot cells around it, otherwise
+it picks from the whole board, using the heatmap either way. The heatmap is built up until moveBudgetMicroseconds runs out,
+and the best cell found by then is attacked, so the enemy never skips its turn.
 Parameters: None
 Return: None
-Side Effects: Modifies the global variables enemyHits, enemyMisses, playerGrid, lastHitXCoordinate, and lastHitYCoordinate.
+Side Effects: Modifies the global variables enemyHits, enemyMisses, playerGrid, lastHitXCoordinate, lastHitYCoordinate,
+and the enemy move timing counters.
 */
 void enemyTurn() {
     int xCoordinate = 0;
     int yCoordinate = 0;
-    int placementAttempts = 0;
-    const int maxPlacementAttempts = 100; // Limit the number of attempts to avoid infinite loop
+    int neighbourOffsets[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}}; // down, up, right, left
+    char excluded[GRID_SIZE][GRID_SIZE]; // cells the enemy must not pick this turn
+    int aimAroundLastHit = 0;
+    int budgetHit = 0;
+    long long startTime = currentMicroseconds();
 
     if (lastHitXCoordinate != GRID_SIZE && lastHitYCoordinate != GRID_SIZE) {
-        // Try to guess around the last hit in a systematic manner
-        if (isValidCoordinate(lastHitXCoordinate + 1, lastHitYCoordinate) && playerGrid[lastHitXCoordinate + 1][lastHitYCoordinate] == SHIP_CELL) {
-            xCoordinate = lastHitXCoordinate + 1;
-            yCoordinate = lastHitYCoordinate;
-        } else if (isValidCoordinate(lastHitXCoordinate - 1, lastHitYCoordinate) && playerGrid[lastHitXCoordinate - 1][lastHitYCoordinate] == SHIP_CELL) {
-            xCoordinate = lastHitXCoordinate - 1;
-            yCoordinate = lastHitYCoordinate;
-        } else if (isValidCoordinate(lastHitXCoordinate, lastHitYCoordinate + 1) && playerGrid[lastHitXCoordinate][lastHitYCoordinate + 1] == SHIP_CELL) {
-            xCoordinate = lastHitXCoordinate;
-            yCoordinate = lastHitYCoordinate + 1;
-        } else if (isValidCoordinate(lastHitXCoordinate, lastHitYCoordinate - 1) && playerGrid[lastHitXCoordinate][lastHitYCoordinate - 1] == SHIP_CELL) {
-            xCoordinate = lastHitXCoordinate;
-            yCoordinate = lastHitYCoordinate - 1;
-        } else {
+        // Only allow the unshot cells around the last hit
+        memset(excluded, 1, sizeof(excluded));
+        for (int direction = 0; direction < 4; direction++) {
+            int neighbourX = lastHitXCoordinate + neighbourOffsets[direction][0];
+            int neighbourY = lastHitYCoordinate + neighbourOffsets[direction][1];
+            if (isValidCoordinate(neighbourX, neighbourY) && isCellUnshot(playerGrid, neighbourX, neighbourY)) {
+                excluded[neighbourX][neighbourY] = 0;
+                aimAroundLastHit = 1;
+            }
+        }
+        if (!aimAroundLastHit) {
             // If all surrounding cells are already guessed, reset lastHitX and lastHitY
             lastHitXCoordinate = GRID_SIZE; // Reset last hit coordinates
             lastHitYCoordinate = GRID_SIZE; // Reset last hit coordinates
-        } 
-    }
-
-    if (lastHitXCoordinate == GRID_SIZE && lastHitYCoordinate == GRID_SIZE) { // If the last hit coordinates are out of range, pick a random cell
-        while (placementAttempts < maxPlacementAttempts) { // while the placement attempts are less than the max placement attempts, pick a random cell on the grid
-            xCoordinate = rand() % GRID_SIZE; // picks x and y coordinates randomly
-            yCoordinate = rand() % GRID_SIZE;
-            if (playerGrid[xCoordinate][yCoordinate] != HIT_CELL && playerGrid[xCoordinate][yCoordinate] != MISS_CELL) { 
-                break;
-            }
-            placementAttempts++; // increment the placement attempts
         }
     }
 
-    if (placementAttempts >= maxPlacementAttempts) { // If the placement attempts are greater than or equal to the max placement attempts, skip the turn
-        printf("Enemy failed to find a valid cell after %d attempts. Skipping turn.\n", maxPlacementAttempts);
-        return; // this should not happen under normal circumstances
+    if (!selectHeatmapTargets(&xCoordinate, &yCoordinate, 1, aimAroundLastHit ? excluded : NULL, startTime + moveBudgetMicroseconds, &budgetHit)) {
+        printf("Enemy has no cells left to attack.\n"); // only possible once every cell has been fired at
+        return;
     }
+    recordEnemyMove(startTime, budgetHit);
 
     // debug flag to print the enemy guess
     if (DEBUG) {
@@ -507,15 +666,14 @@ void enemyTurn() {
         char *shipNames[] = {"Patrol Boat", "Submarine", "Battleship", "Carrier"};    // get the ship names
         printf("Enemy HIT! They hit your %s!\n", shipNames[shipLength - 2]); // print the hit message
         enemyHits++; // increment the enemy hits
-        playerGrid[xCoordinate][yCoordinate] += 10; // mark the player grid at the x and y coordinates as HIT_CELL
-        playerGrid[xCoordinate][yCoordinate] = HIT_CELL; // externally show the hit as 'X'
+        playerGrid[xCoordinate][yCoordinate] += 10; // mark the player grid at the x and y coordinates as hit (printBoard shows it as 'X')
         lastHitXCoordinate = xCoordinate; // set the last hit x coordinate
         lastHitYCoordinate = yCoordinate; // set the last hit y coordinate
         // debug flag to print the marked player grid
         if (DEBUG) {
             printf("Marked player grid at (%d, %d) as HIT_CELL\n", xCoordinate, yCoordinate);
         }
-        hitAndSunkShips(playerGrid, &playerSunkShips);
+        hitAndSunkShips(playerGrid, &playerSunkShips, playerShipsAnnounced, 1);
     } else {
         printf("Enemy MISS!\n"); // print the miss message
         enemyMisses++; // increment the enemy misses
@@ -542,9 +700,231 @@ void enemyTurn() {
     }
 }
 
+/*-----------------------------------Unshot Cell Check-----------------------------------*/
+/*
+Purpose: Check if a cell on a grid has not been fired at yet.
+Parameters: char grid[GRID_SIZE][GRID_SIZE] - the grid to check.
+            int xCoordinate - the x coordinate of the cell.
+            int yCoordinate - the y coordinate of the cell.
+Return: 1 if the cell has not been fired at, 0 if it has already been hit or missed.
+Side Effects: None
+*/
+int isCellUnshot(char grid[GRID_SIZE][GRID_SIZE], int xCoordinate, int yCoordinate) {
+    char cell = grid[xCoordinate][yCoordinate];
+    if (cell == HIT_CELL || cell == MISS_CELL) { // if the cell has been marked as a hit or a miss, it has been shot
+        return 0;
+    }
+    if (cell >= '2' + 10 && cell <= '5' + 10) { // if the cell is a ship cell that has been hit (ship length + 10), it has been shot
+        return 0;
+    }
+    return 1;
+}
+
+/*-----------------------------------Resolve Volley function-----------------------------------*/
+/*
+Purpose: Resolve a whole salvo volley in one step. Every shot is marked on the grid first, the hits are tallied per ship,
+and then all of the hit and sunk messages for the volley are printed together.
+Parameters: char grid[GRID_SIZE][GRID_SIZE] - the grid being fired at.
+            char viewGrid[GRID_SIZE][GRID_SIZE] - the shooter's view of that grid (NULL if there is none).
+            const int volleyX[] - the x coordinates of the shots (must be distinct, unshot cells).
+            const int volleyY[] - the y coordinates of the shots.
+            int shotCount - the number of shots in the volley.
+            int* hitCount - a pointer to the shooter's hit counter.
+            int* missCount - a pointer to the shooter's miss counter.
+            int* sunkShipCount - a pointer to the sunk ship counter of the grid being fired at.
+            int enemyVolley - 1 if the enemy is firing, 0 if the player is firing (only changes the messages).
+Return: The number of hits in the volley.
+Side Effects: Modifies grid, viewGrid, hitCount, missCount and sunkShipCount.
+*/
+int resolveVolley(char grid[GRID_SIZE][GRID_SIZE], char viewGrid[GRID_SIZE][GRID_SIZE], const int volleyX[], const int volleyY[], int shotCount, int* hitCount, int* missCount, int* sunkShipCount, int enemyVolley) {
+    char *shipNames[] = {"Patrol Boat", "Submarine", "Battleship", "Carrier"}; // indexed by ship length - 2
+    int shipHits[4] = {0, 0, 0, 0}; // hits landed on each ship during this volley, indexed by ship length - 2
+    int volleyHits = 0;
+
+    // Mark every shot of the volley on the grid in one pass
+    for (int shotIndex = 0; shotIndex < shotCount; shotIndex++) {
+        int xCoordinate = volleyX[shotIndex];
+        int yCoordinate = volleyY[shotIndex];
+        if (grid[xCoordinate][yCoordinate] >= '2' && grid[xCoordinate][yCoordinate] <= '5') { // if the shot landed on a ship,
+            shipHits[grid[xCoordinate][yCoordinate] - '2']++;                                  // count the hit against that ship
+            grid[xCoordinate][yCoordinate] += 10; // Mark as hit
+            if (viewGrid != NULL) {
+                viewGrid[xCoordinate][yCoordinate] = HIT_CELL;
+            }
+            volleyHits++;
+        } else {
+            grid[xCoordinate][yCoordinate] = MISS_CELL; // Mark as miss
+            if (viewGrid != NULL) {
+                viewGrid[xCoordinate][yCoordinate] = MISS_CELL;
+            }
+        }
+        if (DEBUG) {
+            printf("Volley shot %d at (%d, %d)\n", shotIndex + 1, xCoordinate + 1, yCoordinate + 1);
+        }
+    }
+    *hitCount += volleyHits;
+    *missCount += shotCount - volleyHits;
+
+    // Report the whole volley at once
+    printf("%s fired %d shot(s): %d hit(s), %d miss(es).\n", enemyVolley ? "The enemy" : "You", shotCount, volleyHits, shotCount - volleyHits);
+    for (int shipIndex = 0; shipIndex < 4; shipIndex++) { // for each ship that was hit during the volley, print the hit message
+        if (shipHits[shipIndex] > 0) {
+            if (enemyVolley) {
+                printf("Enemy HIT! They hit your %s %d time(s)!\n", shipNames[shipIndex], shipHits[shipIndex]);
+            } else {
+                printf("HIT! You hit a %s %d time(s)!\n", shipNames[shipIndex], shipHits[shipIndex]);
+            }
+        }
+    }
+    hitAndSunkShips(grid, sunkShipCount, enemyVolley ? playerShipsAnnounced : enemyShipsAnnounced, enemyVolley); // count the sunk ships once for the whole volley
+    return volleyHits;
+}
+
+/*-----------------------------------Select Enemy Volley function-----------------------------------*/
+/*
+Purpose: Pick the cells for the enemy's salvo. The unshot cells around the last hit are picked first since they most likely
+hold the rest of that ship, then the volley is filled with the distinct unshot cells the heatmap rates highest.
+Parameters: int volleyX[] - an array to store the x coordinates of the volley.
+            int volleyY[] - an array to store the y coordinates of the volley.
+            int shotCount - the number of shots to pick.
+            long long deadline - the time (from currentMicroseconds) by which the volley must be picked.
+            int* budgetHit - set to 1 if the deadline cut the heatmap short, 0 otherwise.
+Return: The number of shots picked (less than shotCount only if the board runs out of unshot cells).
+Side Effects: Modifies the volleyX, volleyY, and budgetHit parameters.
+*/
+int selectEnemyVolley(int volleyX[], int volleyY[], int shotCount, long long deadline, int* budgetHit) {
+    int neighbourOffsets[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}}; // down, up, right, left
+    char chosen[GRID_SIZE][GRID_SIZE]; // marks the cells already in the volley so no cell is picked twice
+    int chosenCount = 0;
+    memset(chosen, 0, sizeof(chosen));
+
+    if (lastHitXCoordinate != GRID_SIZE && lastHitYCoordinate != GRID_SIZE) { // if the enemy has a recent hit, aim around it first
+        for (int direction = 0; direction < 4 && chosenCount < shotCount; direction++) {
+            int xCoordinate = lastHitXCoordinate + neighbourOffsets[direction][0];
+            int yCoordinate = lastHitYCoordinate + neighbourOffsets[direction][1];
+            if (isValidCoordinate(xCoordinate, yCoordinate) && isCellUnshot(playerGrid, xCoordinate, yCoordinate)) {
+                volleyX[chosenCount] = xCoordinate;
+                volleyY[chosenCount] = yCoordinate;
+                chosen[xCoordinate][yCoordinate] = 1;
+                chosenCount++;
+            }
+        }
+    }
+
+    if (chosenCount < shotCount) { // fill the rest of the volley from the heatmap
+        chosenCount += selectHeatmapTargets(volleyX + chosenCount, volleyY + chosenCount, shotCount - chosenCount, chosen, deadline, budgetHit);
+    } else {
+        *budgetHit = 0;
+    }
+    return chosenCount;
+}
+
+/*-----------------------------------Player Salvo Turn function-----------------------------------*/
+/*
+Purpose: Allow the player to fire their salvo. The player gets one shot for each of their ships still afloat,
+and the whole volley is resolved at once after every shot has been entered.
+Parameters: None
+Return: None
+Side Effects: Modifies the global variables playerHits, playerMisses, enemySunkShips, enemyGrid, playerViewOfEnemyGrid, and gameSaved.
+*/
+void playerSalvoTurn() {
+    int volleyX[MAX_SALVO_SHOTS];
+    int volleyY[MAX_SALVO_SHOTS];
+    int shotCount = MAX_SALVO_SHOTS - playerSunkShips; // one shot for each of the player's ships still afloat
+    int unshotCells = 0;
+
+    for (int row = 0; row < GRID_SIZE; row++) { // count the cells the player has not fired at yet
+        for (int col = 0; col < GRID_SIZE; col++) {
+            if (playerViewOfEnemyGrid[row][col] != HIT_CELL && playerViewOfEnemyGrid[row][col] != MISS_CELL) {
+                unshotCells++;
+            }
+        }
+    }
+    if (shotCount > unshotCells) { // never ask for more shots than there are cells left to fire at
+        shotCount = unshotCells;
+    }
+    printf("\nYour salvo. You have %d shot(s) this turn.\n", shotCount);
+    for (int shotIndex = 0; shotIndex < shotCount; shotIndex++) {
+        int duplicateShot = 0;
+        printf("\nShot %d of %d:\n", shotIndex + 1, shotCount);
+        int xCoordinate = getAttackCoordinate("Enter X coordinate to attack (1-10, 0 to save and quit): ");
+        if (xCoordinate == SAVE_AND_QUIT) { // nothing of this volley has landed yet, so the game can be parked as it is
+            if (saveGameAndQuit()) {
+                return;
+            }
+            shotIndex--; // re-enter this shot
+            continue;
+        }
+        int yCoordinate = getValidCoordinate("Enter Y coordinate to attack (1-10): ");
+
+        if (playerViewOfEnemyGrid[xCoordinate][yCoordinate] == HIT_CELL || playerViewOfEnemyGrid[xCoordinate][yCoordinate] == MISS_CELL) {
+            printf("You have already guessed these coordinates. Please pick another cell.\n");
+            shotIndex--; // re-enter this shot
+            continue;
+        }
+        for (int previousShot = 0; previousShot < shotIndex; previousShot++) { // check the cell is not already in this volley
+            if (volleyX[previousShot] == xCoordinate && volleyY[previousShot] == yCoordinate) {
+                duplicateShot = 1;
+            }
+        }
+        if (duplicateShot) {
+            printf("That cell is already part of this salvo. Please pick another cell.\n");
+            shotIndex--; // re-enter this shot
+            continue;
+        }
+        volleyX[shotIndex] = xCoordinate;
+        volleyY[shotIndex] = yCoordinate;
+    }
+
+    resolveVolley(enemyGrid, playerViewOfEnemyGrid, volleyX, volleyY, shotCount, &playerHits, &playerMisses, &enemySunkShips, 0);
+
+    displayBoard(playerGrid, "Your Board");
+    displayBoard(playerViewOfEnemyGrid, "Enemy Board");
+
+    if (DEBUG) {
+        printf("Player salvo completed. playerHits: %d, playerMisses: %d\n", playerHits, playerMisses);
+    }
+}
+
+/*-----------------------------------Enemy Salvo Turn function-----------------------------------*/
+/*
+Purpose: Allow the enemy to fire its salvo. The enemy gets one shot for each of its ships still afloat,
+and the whole volley is resolved at once.
+Parameters: None
+Return: None
+Side Effects: Modifies the global variables enemyHits, enemyMisses, playerSunkShips, playerGrid, lastHitXCoordinate, lastHitYCoordinate,
+and the enemy move timing counters.
+*/
+void enemySalvoTurn() {
+    int volleyX[MAX_SALVO_SHOTS];
+    int volleyY[MAX_SALVO_SHOTS];
+    int budgetHit = 0;
+    long long startTime = currentMicroseconds();
+    int shotCount = selectEnemyVolley(volleyX, volleyY, MAX_SALVO_SHOTS - enemySunkShips, startTime + moveBudgetMicroseconds, &budgetHit); // one shot for each enemy ship still afloat
+    recordEnemyMove(startTime, budgetHit);
+
+    printf("\nEnemy salvo.\n");
+    resolveVolley(playerGrid, NULL, volleyX, volleyY, shotCount, &enemyHits, &enemyMisses, &playerSunkShips, 1);
+
+    lastHitXCoordinate = GRID_SIZE; // Reset last hit coordinates
+    lastHitYCoordinate = GRID_SIZE; // Reset last hit coordinates
+    for (int shotIndex = 0; shotIndex < shotCount; shotIndex++) { // remember the last hit of the volley so the next volley can aim around it
+        if (playerGrid[volleyX[shotIndex]][volleyY[shotIndex]] != MISS_CELL) {
+            lastHitXCoordinate = volleyX[shotIndex];
+            lastHitYCoordinate = volleyY[shotIndex];
+        }
+    }
+
+    printBoard(playerGrid, "Your Board");
+    if (DEBUG) {
+        printf("Enemy salvo completed. enemyHits: %d, enemyMisses: %d\n", enemyHits, enemyMisses);
+    }
+}
+
 /*-----------------------------------Game Statistics-----------------------------------*/
 /*
-Purpose: Display the game statistics. The function will display the number of ships hit, missed, and sunk by the player and the enemy.
+Purpose: Display the game statistics. The function will display the number of ships hit, missed, and sunk by the player and the enemy,
+and how often the enemy ran out of thinking time.
 Parameters: None
 Return: None
 Side Effects: None
@@ -555,8 +935,10 @@ void displayStatistics() {
     printf("=====================================\n");
     printf("Number of ships hit: %d\n", playerHits);
     printf("Number of ships missed: %d\n", playerMisses);
-    printf("Number of ships sunk: %d\n", playerSunkShips);
-    printf("Number of ships sunk by the enemy: %d\n", enemySunkShips);
+    printf("Number of ships sunk: %d\n", enemySunkShips);
+    printf("Number of ships sunk by the enemy: %d\n", playerSunkShips);
+    printf("Enemy moves that ran out of thinking time: %ld of %ld\n", enemyMovesOverBudget, enemyMovesPlayed);
+    printf("Average enemy thinking time: %.1f microseconds\n", enemyMovesPlayed ? (double)enemyThinkingMicroseconds / enemyMovesPlayed : 0.0);
     printf("=====================================\n");
 }
 
@@ -639,13 +1021,12 @@ void placeShip(int xCoordinate, int yCoordinate, int shipLength, char shipOrient
 /*
 Purpose: To count ship hits and to check if the ships are sunk. If all cells of a ship are hit, the ship is sunk.
 Parameters: char grid[GRID_SIZE][GRID_SIZE] - the grid to check for sunk ships.
-            int sunkShipCount - a pointer to an integer to store the count of sunk ships.
-Return: None
-Side Effects: Modifies the grid parameter and the sunkShipCount parameter.
+            int shipSunk[4] - an array to store whether each ship (Carrier, Battleship, Submarine, Patrol Boat) is sunk.
+Return: The number of sunk ships.
+Side Effects: Modifies the shipSunk parameter.
 */
-void hitAndSunkShips(char grid[GRID_SIZE][GRID_SIZE], int* sunkShipCount) { 
+int countSunkShips(char grid[GRID_SIZE][GRID_SIZE], int shipSunk[4]) {
     int shipLengths[] = {5, 4, 3, 2}; // Carrier, Battleship, Submarine, Patrol Boat
-    char* shipNames[] = {"Carrier", "Battleship", "Submarine", "Patrol Boat"}; // note: changed to array of strings
     int sunkCount = 0; // Initialize the sunk ship count to 0
 
     for (int shipIndex = 0; shipIndex < 4; shipIndex++) { // for each ship, check if the ship is sunk
@@ -662,31 +1043,823 @@ void hitAndSunkShips(char grid[GRID_SIZE][GRID_SIZE], int* sunkShipCount) {
         }
 
         // If we've hit all cells of this ship's length, it's sunk
-        if (hitCount == length) {
+        shipSunk[shipIndex] = (hitCount == length);
+        if (shipSunk[shipIndex]) {
             sunkCount++;
-            printf("You sunk a %s!\n", shipNames[shipIndex]);
         }
     }
+    return sunkCount;
+}
+
+/*
+Purpose: Update the sunk ship count of a grid and announce each ship the first time it is sunk.
+Parameters: char grid[GRID_SIZE][GRID_SIZE] - the grid to check for sunk ships.
+            int* sunkShipCount - a pointer to an integer to store the count of sunk ships.
+            int shipAnnounced[4] - which ships of this grid have already been announced as sunk.
+            int enemyFiring - 1 if the enemy is firing at this grid, 0 if the player is (only changes the messages).
+Return: None
+Side Effects: Modifies the sunkShipCount and shipAnnounced parameters.
+*/
+void hitAndSunkShips(char grid[GRID_SIZE][GRID_SIZE], int* sunkShipCount, int shipAnnounced[4], int enemyFiring) { 
+    char* shipNames[] = {"Carrier", "Battleship", "Submarine", "Patrol Boat"}; // note: changed to array of strings
+    int shipSunk[4];
+
+    *sunkShipCount = countSunkShips(grid, shipSunk); // Update the sunk ship count
+    for (int shipIndex = 0; shipIndex < 4; shipIndex++) { // announce only the ships that were sunk since the last check
+        if (shipSunk[shipIndex] && !shipAnnounced[shipIndex]) {
+            if (enemyFiring) {
+                printf("The enemy sunk your %s!\n", shipNames[shipIndex]);
+            } else {
+                printf("You sunk a %s!\n", shipNames[shipIndex]);
+            }
+            shipAnnounced[shipIndex] = 1;
+        }
+    }
+}
+
+/*-----------------------------------Heatmap Targeting Functions-----------------------------------*/
+/*
+Purpose: Build the table of every possible ship placement on an empty board, as cell bitmasks.
+Parameters: None
+Return: None
+Side Effects: Modifies the global variables placementMasks, placementShips, and placementCount.
+*/
+void buildPlacementTable() {
+    int shipLengths[] = {5, 4, 3, 2}; // Carrier, Battleship, Submarine, Patrol Boat
+    placementCount = 0;
+    for (int shipIndex = 0; shipIndex < 4; shipIndex++) {
+        int length = shipLengths[shipIndex];
+        for (int vertical = 0; vertical < 2; vertical++) { // horizontal placements first, then vertical ones
+            for (int row = 0; row + (vertical ? length : 1) <= GRID_SIZE; row++) {
+                for (int col = 0; col + (vertical ? 1 : length) <= GRID_SIZE; col++) {
+                    CellMask mask = {{0, 0}};
+                    for (int index = 0; index < length; index++) { // set the bit of each cell the ship covers
+                        int cellIndex = vertical ? (row + index) * GRID_SIZE + col : row * GRID_SIZE + col + index;
+                        mask.bits[cellIndex / 64] |= (uint64_t)1 << (cellIndex % 64);
+                    }
+                    placementMasks[placementCount] = mask;
+                    placementShips[placementCount] = shipIndex;
+                    placementCount++;
+                }
+            }
+        }
+    }
+}
+
+/*
+Purpose: Add every placement mask into the per-cell heatmap counters (portable version).
+Parameters: const CellMask* placements - the placement masks to add.
+            int count - the number of placement masks.
+            uint16_t counters[HEATMAP_CELLS] - the per-cell counters to add into.
+Return: None
+Side Effects: Modifies the counters parameter.
+*/
+void accumulateHeatmapScalar(const CellMask* placements, int count, uint16_t counters[HEATMAP_CELLS]) {
+    for (int placementIndex = 0; placementIndex < count; placementIndex++) {
+        for (int wordIndex = 0; wordIndex < 2; wordIndex++) {
+            uint64_t word = placements[placementIndex].bits[wordIndex];
+            while (word != 0) { // for each cell the placement covers,
+#if defined(__GNUC__)
+                int bit = __builtin_ctzll(word);
+#else
+                int bit = 0;
+                while (!((word >> bit) & 1)) {
+                    bit++;
+                }
+#endif
+                counters[wordIndex * 64 + bit]++; // count it
+                word &= word - 1; // clear the lowest set bit
+            }
+        }
+    }
+}
+
+#if HEATMAP_X86
+/*
+Purpose: Carry-save add three 128-bit masks: every bit position gets a sum bit and a carry bit, like a full adder.
+Parameters: __m128i* carry - where to store the carry bits (worth twice the inputs).
+            __m128i* sum - where to store the sum bits.
+            __m128i a, b, c - the masks to add.
+Return: None
+Side Effects: Modifies the carry and sum parameters.
+*/
+__attribute__((target("sse2")))
+static inline void carrySaveAddSSE2(__m128i* carry, __m128i* sum, __m128i a, __m128i b, __m128i c) {
+    __m128i partial = _mm_xor_si128(a, b);
+    *carry = _mm_or_si128(_mm_and_si128(a, b), _mm_and_si128(partial, c));
+    *sum = _mm_xor_si128(partial, c);
+}
+
+/*
+Purpose: Add a bit plane into the SSE2 heatmap counters: every cell whose bit is set goes up by weight.
+Parameters: __m128i plane - the bit plane (bit n is cell n).
+            int weight - the amount each set cell is worth.
+            __m128i sums[HEATMAP_SSE2_CHUNKS] - the counters, 8 cells per vector.
+Return: None
+Side Effects: Modifies the sums parameter.
+*/
+__attribute__((target("sse2")))
+static inline void addPlaneSSE2(__m128i plane, int weight, __m128i sums[HEATMAP_SSE2_CHUNKS]) {
+    const __m128i laneBits = _mm_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128); // the bit of the mask byte each lane stands for
+    const __m128i laneWeight = _mm_set1_epi16((short)weight);
+    uint64_t words[2];
+    _mm_storeu_si128((__m128i*)words, plane);
+    for (int chunk = 0; chunk < HEATMAP_SSE2_CHUNKS; chunk++) { // spread each byte of the plane over 8 counter lanes
+        int maskByte = (int)((words[chunk / 8] >> (8 * (chunk % 8))) & 0xFF);
+        __m128i lanes = _mm_cmpeq_epi16(_mm_and_si128(_mm_set1_epi16((short)maskByte), laneBits), laneBits);
+        sums[chunk] = _mm_add_epi16(sums[chunk], _mm_and_si128(lanes, laneWeight));
+    }
+}
+
+/*
+Purpose: Add every placement mask into the per-cell heatmap counters with SSE2. A whole placement mask fits in one register,
+so 8 placements at a time are added bit-sliced with carry-save adders (ones, twos, fours), and the eights go into a
+bit-sliced counter. The bit planes are only spread out into the 16-bit counters once at the end.
+Parameters: Same as accumulateHeatmapScalar.
+Return: None
+Side Effects: Modifies the counters parameter.
+*/
+__attribute__((target("sse2")))
+void accumulateHeatmapSSE2(const CellMask* placements, int count, uint16_t counters[HEATMAP_CELLS]) {
+    __m128i sums[HEATMAP_SSE2_CHUNKS];
+    __m128i ones = _mm_setzero_si128();
+    __m128i twos = _mm_setzero_si128();
+    __m128i fours = _mm_setzero_si128();
+    __m128i eights[HEATMAP_EIGHTS_PLANES]; // bit-sliced count of the eights (plane n is worth 8 << n)
+    __m128i twosA, twosB, foursA, foursB, eightsCarry;
+    int batchEnd = count - count % 8;
+
+    for (int plane = 0; plane < HEATMAP_EIGHTS_PLANES; plane++) {
+        eights[plane] = _mm_setzero_si128();
+    }
+    for (int placementIndex = 0; placementIndex < batchEnd; placementIndex += 8) {
+        const __m128i* batch = (const __m128i*)&placements[placementIndex];
+        carrySaveAddSSE2(&twosA, &ones, ones, _mm_loadu_si128(batch), _mm_loadu_si128(batch + 1));
+        carrySaveAddSSE2(&twosB, &ones, ones, _mm_loadu_si128(batch + 2), _mm_loadu_si128(batch + 3));
+        carrySaveAddSSE2(&foursA, &twos, twos, twosA, twosB);
+        carrySaveAddSSE2(&twosA, &ones, ones, _mm_loadu_si128(batch + 4), _mm_loadu_si128(batch + 5));
+        carrySaveAddSSE2(&twosB, &ones, ones, _mm_loadu_si128(batch + 6), _mm_loadu_si128(batch + 7));
+        carrySaveAddSSE2(&foursB, &twos, twos, twosA, twosB);
+        carrySaveAddSSE2(&eightsCarry, &fours, fours, foursA, foursB);
+#pragma GCC unroll 8
+        for (int plane = 0; plane < HEATMAP_EIGHTS_PLANES; plane++) { // ripple the eights into their counter
+            __m128i planeCarry = _mm_and_si128(eights[plane], eightsCarry);
+            eights[plane] = _mm_xor_si128(eights[plane], eightsCarry);
+            eightsCarry = planeCarry;
+        }
+    }
+
+    for (int chunk = 0; chunk < HEATMAP_SSE2_CHUNKS; chunk++) {
+        sums[chunk] = _mm_loadu_si128((const __m128i*)&counters[chunk * 8]);
+    }
+    addPlaneSSE2(ones, 1, sums);
+    addPlaneSSE2(twos, 2, sums);
+    addPlaneSSE2(fours, 4, sums);
+    for (int plane = 0; plane < HEATMAP_EIGHTS_PLANES; plane++) {
+        addPlaneSSE2(eights[plane], 8 << plane, sums);
+    }
+    for (int chunk = 0; chunk < HEATMAP_SSE2_CHUNKS; chunk++) {
+        _mm_storeu_si128((__m128i*)&counters[chunk * 8], sums[chunk]);
+    }
+    accumulateHeatmapScalar(placements + batchEnd, count - batchEnd, counters); // the placements left over after the last full batch
+}
+
+/*
+Purpose: Carry-save add three 256-bit masks (see carrySaveAddSSE2).
+Parameters: __m256i* carry - where to store the carry bits.
+            __m256i* sum - where to store the sum bits.
+            __m256i a, b, c - the masks to add.
+Return: None
+Side Effects: Modifies the carry and sum parameters.
+*/
+__attribute__((target("avx2")))
+static inline void carrySaveAddAVX2(__m256i* carry, __m256i* sum, __m256i a, __m256i b, __m256i c) {
+    __m256i partial = _mm256_xor_si256(a, b);
+    *carry = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(partial, c));
+    *sum = _mm256_xor_si256(partial, c);
+}
+
+/*
+Purpose: Add a bit plane into the AVX2 heatmap counters. The plane holds two separate 128-bit halves (one per placement
+stream), and both are added into the same counters.
+Parameters: __m256i plane - the bit plane (bit n of each half is cell n).
+            int weight - the amount each set cell is worth.
+            __m256i sums[HEATMAP_AVX2_CHUNKS] - the counters, 16 cells per vector.
+Return: None
+Side Effects: Modifies the sums parameter.
+*/
+__attribute__((target("avx2")))
+static inline void addPlaneAVX2(__m256i plane, int weight, __m256i sums[HEATMAP_AVX2_CHUNKS]) {
+    const __m256i laneBits = _mm256_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, (short)0x8000);
+    const __m256i laneWeight = _mm256_set1_epi16((short)weight);
+    uint64_t words[4];
+    _mm256_storeu_si256((__m256i*)words, plane);
+    for (int half = 0; half < 2; half++) {
+        for (int chunk = 0; chunk < HEATMAP_AVX2_CHUNKS; chunk++) { // spread each 16-bit piece of the plane over 16 counter lanes
+            int maskWord = (int)((words[half * 2 + chunk / 4] >> (16 * (chunk % 4))) & 0xFFFF);
+            __m256i lanes = _mm256_cmpeq_epi16(_mm256_and_si256(_mm256_set1_epi16((short)maskWord), laneBits), laneBits);
+            sums[chunk] = _mm256_add_epi16(sums[chunk], _mm256_and_si256(lanes, laneWeight));
+        }
+    }
+}
+
+/*
+Purpose: Add every placement mask into the per-cell heatmap counters with AVX2. Works like accumulateHeatmapSSE2,
+but each register holds two placements, so 16 placements are added per batch.
+Parameters: Same as accumulateHeatmapScalar.
+Return: None
+Side Effects: Modifies the counters parameter.
+*/
+__attribute__((target("avx2")))
+void accumulateHeatmapAVX2(const CellMask* placements, int count, uint16_t counters[HEATMAP_CELLS]) {
+    __m256i sums[HEATMAP_AVX2_CHUNKS];
+    __m256i ones = _mm256_setzero_si256();
+    __m256i twos = _mm256_setzero_si256();
+    __m256i fours = _mm256_setzero_si256();
+    __m256i eights[HEATMAP_EIGHTS_PLANES]; // bit-sliced count of the eights (plane n is worth 8 << n)
+    __m256i twosA, twosB, foursA, foursB, eightsCarry;
+    int batchEnd = count - count % 16;
+
+    for (int plane = 0; plane < HEATMAP_EIGHTS_PLANES; plane++) {
+        eights[plane] = _mm256_setzero_si256();
+    }
+    for (int placementIndex = 0; placementIndex < batchEnd; placementIndex += 16) {
+        const __m256i* batch = (const __m256i*)&placements[placementIndex];
+        carrySaveAddAVX2(&twosA, &ones, ones, _mm256_loadu_si256(batch), _mm256_loadu_si256(batch + 1));
+        carrySaveAddAVX2(&twosB, &ones, ones, _mm256_loadu_si256(batch + 2), _mm256_loadu_si256(batch + 3));
+        carrySaveAddAVX2(&foursA, &twos, twos, twosA, twosB);
+        carrySaveAddAVX2(&twosA, &ones, ones, _mm256_loadu_si256(batch + 4), _mm256_loadu_si256(batch + 5));
+        carrySaveAddAVX2(&twosB, &ones, ones, _mm256_loadu_si256(batch + 6), _mm256_loadu_si256(batch + 7));
+        carrySaveAddAVX2(&foursB, &twos, twos, twosA, twosB);
+        carrySaveAddAVX2(&eightsCarry, &fours, fours, foursA, foursB);
+#pragma GCC unroll 8
+        for (int plane = 0; plane < HEATMAP_EIGHTS_PLANES; plane++) { // ripple the eights into their counter
+            __m256i planeCarry = _mm256_and_si256(eights[plane], eightsCarry);
+            eights[plane] = _mm256_xor_si256(eights[plane], eightsCarry);
+            eightsCarry = planeCarry;
+        }
+    }
+
+    for (int chunk = 0; chunk < HEATMAP_AVX2_CHUNKS; chunk++) {
+        sums[chunk] = _mm256_loadu_si256((const __m256i*)&counters[chunk * 16]);
+    }
+    addPlaneAVX2(ones, 1, sums);
+    addPlaneAVX2(twos, 2, sums);
+    addPlaneAVX2(fours, 4, sums);
+    for (int plane = 0; plane < HEATMAP_EIGHTS_PLANES; plane++) {
+        addPlaneAVX2(eights[plane], 8 << plane, sums);
+    }
+    for (int chunk = 0; chunk < HEATMAP_AVX2_CHUNKS; chunk++) {
+        _mm256_storeu_si256((__m256i*)&counters[chunk * 16], sums[chunk]);
+    }
+    _mm256_zeroupper(); // clear the upper halves of the AVX registers so the SSE code that runs after this does not slow down
+    accumulateHeatmapScalar(placements + batchEnd, count - batchEnd, counters); // the placements left over after the last full batch
+}
+#endif
+
+/*
+Purpose: Pick the fastest heatmap kernel this CPU supports and build the placement table.
+Parameters: None
+Return: None
+Side Effects: Modifies the global variables accumulateHeatmap, heatmapKernelName, placementMasks, placementShips, and placementCount.
+*/
+void initHeatmapKernel() {
+    buildPlacementTable();
+    accumulateHeatmap = accumulateHeatmapScalar;
+    heatmapKernelName = "scalar";
+#if HEATMAP_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        accumulateHeatmap = accumulateHeatmapAVX2;
+        heatmapKernelName = "AVX2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        accumulateHeatmap = accumulateHeatmapSSE2;
+        heatmapKernelName = "SSE2";
+    }
+#endif
+}
+
+/*
+Purpose: Find the candidate cell with the highest heatmap count.
+Parameters: const uint16_t counters[HEATMAP_CELLS] - the per-cell counters.
+            const CellMask* candidates - the cells that may be picked.
+            int startCell - the cell to start scanning from (ties go to the first cell found, so a random start spreads them out).
+Return: The index of the best cell (row * GRID_SIZE + col), or -1 if there are no candidates.
+Side Effects: None
+*/
+int heatmapArgmax(const uint16_t counters[HEATMAP_CELLS], const CellMask* candidates, int startCell) {
+    int bestCell = -1;
+    int bestCount = -1;
+    for (int offset = 0; offset < GRID_SIZE * GRID_SIZE; offset++) {
+        int cellIndex = (startCell + offset) % (GRID_SIZE * GRID_SIZE);
+        if (((candidates->bits[cellIndex / 64] >> (cellIndex % 64)) & 1) && counters[cellIndex] > bestCount) {
+            bestCell = cellIndex;
+            bestCount = counters[cellIndex];
+        }
+    }
+    return bestCell;
+}
+
+/*
+Purpose: Pick the cells of the player grid most likely to hold a ship. Every placement of the player's ships still afloat
+that does not cross a miss or a sunk ship is added into a heatmap, and the unshot cells with the highest counts are picked.
+Parameters: int targetX[] - an array to store the x coordinates of the picked cells.
+            int targetY[] - an array to store the y coordinates of the picked cells.
+            int targetCount - the number of cells to pick.
+            char excluded[GRID_SIZE][GRID_SIZE] - cells that must not be picked (NULL if there are none).
+            long long deadline - the time (from currentMicroseconds) by which the cells must be picked. The placements are added
+            in slices, starting at a random one so a cut-short heatmap still covers the board evenly, and the cells are picked
+            from whatever has been added when the deadline passes.
+            int* budgetHit - set to 1 if the deadline cut the heatmap short, 0 otherwise.
+Return: The number of cells picked (less than targetCount only if the board runs out of unshot cells).
+Side Effects: Modifies the targetX, targetY, and budgetHit parameters.
+*/
+int selectHeatmapTargets(int targetX[], int targetY[], int targetCount, char excluded[GRID_SIZE][GRID_SIZE], long long deadline, int* budgetHit) {
+    int shipSunk[4] = {0, 0, 0, 0};
+    CellMask blocked = {{0, 0}}; // misses and sunk ships, which no remaining ship can cross
+    CellMask candidates = {{0, 0}}; // unshot cells that may be picked
+    CellMask validPlacements[HEATMAP_SLICE];
+    uint16_t counters[HEATMAP_CELLS] = {0};
+    int startPlacement = gameRandom() % placementCount;
+    int pickedCount = 0;
+
+    countSunkShips(playerGrid, shipSunk); // the game announces every sunk ship, so the enemy may use this
+    for (int cellIndex = 0; cellIndex < GRID_SIZE * GRID_SIZE; cellIndex++) {
+        char cell = playerGrid[cellIndex / GRID_SIZE][cellIndex % GRID_SIZE];
+        uint64_t cellBit = (uint64_t)1 << (cellIndex % 64);
+        if (cell == MISS_CELL || (cell >= '2' + 10 && cell <= '5' + 10 && shipSunk[5 - (cell - '0' - 10)])) {
+            blocked.bits[cellIndex / 64] |= cellBit;
+        }
+        if (isCellUnshot(playerGrid, cellIndex / GRID_SIZE, cellIndex % GRID_SIZE) && (excluded == NULL || !excluded[cellIndex / GRID_SIZE][cellIndex % GRID_SIZE])) {
+            candidates.bits[cellIndex / 64] |= cellBit;
+        }
+    }
+
+    *budgetHit = 0;
+    for (int sliceStart = 0; sliceStart < placementCount; sliceStart += HEATMAP_SLICE) { // refine the heatmap one slice at a time
+        int validCount = 0;
+        if (currentMicroseconds() >= deadline) { // out of time, so go with the heatmap built so far
+            *budgetHit = 1;
+            break;
+        }
+        for (int offset = sliceStart; offset < sliceStart + HEATMAP_SLICE && offset < placementCount; offset++) { // keep the placements still possible
+            int placementIndex = (startPlacement + offset) % placementCount;
+            const CellMask* mask = &placementMasks[placementIndex];
+            if (!shipSunk[placementShips[placementIndex]] && !(mask->bits[0] & blocked.bits[0]) && !(mask->bits[1] & blocked.bits[1])) {
+                validPlacements[validCount] = *mask;
+                validCount++;
+            }
+        }
+        accumulateHeatmap(validPlacements, validCount, counters);
+    }
+
+    while (pickedCount < targetCount) { // pick the hottest cells one at a time
+        int bestCell = heatmapArgmax(counters, &candidates, gameRandom() % (GRID_SIZE * GRID_SIZE));
+        if (bestCell < 0) {
+            break;
+        }
+        targetX[pickedCount] = bestCell / GRID_SIZE;
+        targetY[pickedCount] = bestCell % GRID_SIZE;
+        candidates.bits[bestCell / 64] &= ~((uint64_t)1 << (bestCell % 64)); // never pick the same cell twice
+        pickedCount++;
+    }
+    return pickedCount;
+}
+
+/*-----------------------------------Heatmap Self-Test and Benchmark-----------------------------------*/
+/*
+Purpose: List the heatmap kernels this build and CPU can run (the scalar kernel is always first).
+Parameters: HeatmapKernel kernels[HEATMAP_KERNEL_COUNT] - an array to store the kernels.
+            const char* kernelNames[HEATMAP_KERNEL_COUNT] - an array to store the kernel names.
+Return: The number of kernels listed.
+Side Effects: Modifies the kernels and kernelNames arrays.
+*/
+int listHeatmapKernels(HeatmapKernel kernels[HEATMAP_KERNEL_COUNT], const char* kernelNames[HEATMAP_KERNEL_COUNT]) {
+    int kernelCount = 0;
+    kernels[kernelCount] = accumulateHeatmapScalar;
+    kernelNames[kernelCount] = "scalar";
+    kernelCount++;
+#if HEATMAP_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        kernels[kernelCount] = accumulateHeatmapSSE2;
+        kernelNames[kernelCount] = "SSE2";
+        kernelCount++;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        kernels[kernelCount] = accumulateHeatmapAVX2;
+        kernelNames[kernelCount] = "AVX2";
+        kernelCount++;
+    }
+#endif
+    return kernelCount;
+}
+
+/*
+Purpose: Check every heatmap kernel against the scalar kernel (run with --selftest). Each trial starts from random non-zero
+counters and makes a chain of kernel calls on random sets of placements, the way selectHeatmapTargets adds one slice at a time,
+so the SIMD kernels are checked on partial batches and on adding into counters that already hold a count.
+Parameters: None
+Return: 0 if every kernel matched the scalar kernel, 1 otherwise (used as the program's exit code).
+Side Effects: Prints the result and modifies the global variable randomState.
+*/
+int runHeatmapSelfTest() {
+    HeatmapKernel kernels[HEATMAP_KERNEL_COUNT];
+    const char* kernelNames[HEATMAP_KERNEL_COUNT];
+    int kernelCount = listHeatmapKernels(kernels, kernelNames);
+    CellMask placements[MAX_PLACEMENTS];
+    uint16_t counters[HEATMAP_KERNEL_COUNT][HEATMAP_CELLS]; // one set of counters per kernel (the scalar kernel's first)
+    int mismatches = 0;
+
+    seedRandom(1); // fixed seed so a failure can be reproduced
+    for (int trial = 0; trial < HEATMAP_SELFTEST_TRIALS; trial++) {
+        int callCount = 1 + gameRandom() % HEATMAP_SELFTEST_CALLS;
+        for (int cellIndex = 0; cellIndex < HEATMAP_CELLS; cellIndex++) { // every kernel starts from the same random counters
+            uint16_t startCount = (uint16_t)(gameRandom() % HEATMAP_SELFTEST_MAX_START);
+            for (int kernelIndex = 0; kernelIndex < kernelCount; kernelIndex++) {
+                counters[kernelIndex][cellIndex] = startCount;
+            }
+        }
+        for (int call = 0; call < callCount; call++) {
+            int count = gameRandom() % (placementCount + 1);
+            for (int placementIndex = 0; placementIndex < count; placementIndex++) { // random placements from the table (repeats allowed)
+                placements[placementIndex] = placementMasks[gameRandom() % placementCount];
+            }
+            for (int kernelIndex = 0; kernelIndex < kernelCount; kernelIndex++) {
+                kernels[kernelIndex](placements, count, counters[kernelIndex]);
+            }
+        }
+        for (int kernelIndex = 1; kernelIndex < kernelCount; kernelIndex++) {
+            if (memcmp(counters[0], counters[kernelIndex], sizeof(counters[0])) != 0) {
+                printf("Mismatch: %s kernel, trial %d, %d call(s)\n", kernelNames[kernelIndex], trial, callCount);
+                mismatches++;
+            }
+        }
+    }
+    printf("Heatmap self-test: %d kernel(s) checked against scalar over %d trials, %d mismatch(es)\n", kernelCount - 1, HEATMAP_SELFTEST_TRIALS, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
+
+/*
+Purpose: Time every heatmap kernel on the full placement table, and the whole enemy move selection (run with --bench).
+Parameters: None
+Return: None
+Side Effects: Prints the timings and resets the game state.
+*/
+void runHeatmapBenchmark() {
+    HeatmapKernel kernels[HEATMAP_KERNEL_COUNT];
+    const char* kernelNames[HEATMAP_KERNEL_COUNT];
+    int kernelCount = listHeatmapKernels(kernels, kernelNames);
+    long checksum = 0; // printed so the timed work is always used
+    int xCoordinate = 0;
+    int yCoordinate = 0;
+    int budgetHit = 0;
+
+    printf("Heatmap benchmark: %d placements, %d runs each (selected kernel: %s)\n", placementCount, HEATMAP_BENCH_RUNS, heatmapKernelName);
+    for (int kernelIndex = 0; kernelIndex < kernelCount; kernelIndex++) {
+        uint16_t counters[HEATMAP_CELLS];
+        long long startTime = currentMicroseconds();
+        for (int run = 0; run < HEATMAP_BENCH_RUNS; run++) {
+            memset(counters, 0, sizeof(counters));
+            kernels[kernelIndex](placementMasks, placementCount, counters);
+            checksum += counters[run % (GRID_SIZE * GRID_SIZE)];
+        }
+        printf("  %-8s %.3f microseconds per heatmap\n", kernelNames[kernelIndex], (double)(currentMicroseconds() - startTime) / HEATMAP_BENCH_RUNS);
+    }
+
+    initializeGame(); // time a full enemy move on a fresh board holding a random fleet
+    placeEnemyShips();
+    memcpy(playerGrid, enemyGrid, sizeof(playerGrid));
+    long long startTime = currentMicroseconds();
+    for (int run = 0; run < HEATMAP_BENCH_RUNS; run++) {
+        selectHeatmapTargets(&xCoordinate, &yCoordinate, 1, NULL, currentMicroseconds() + moveBudgetMicroseconds, &budgetHit);
+        checksum += xCoordinate * GRID_SIZE + yCoordinate;
+    }
+    printf("  enemy move selection: %.3f microseconds per move (budget %lld microseconds)\n", (double)(currentMicroseconds() - startTime) / HEATMAP_BENCH_RUNS, moveBudgetMicroseconds);
+    printf("  (checksum %ld)\n", checksum);
+    initializeGame();
+}
+
+/*-----------------------------------Snapshot Functions-----------------------------------*/
+/*
+Purpose: Pack the ships of a grid into the snapshot fleet format. Every ship has a unique length, so the first cell of that
+length (in row order) is the start of the ship, and the cell to its right tells the orientation.
+Parameters: char grid[GRID_SIZE][GRID_SIZE] - the grid holding the fleet.
+            unsigned char fleet[4] - an array to store the packed ships (Carrier, Battleship, Submarine, Patrol Boat).
+Return: None
+Side Effects: Modifies the fleet array.
+*/
+void packFleet(char grid[GRID_SIZE][GRID_SIZE], unsigned char fleet[4]) {
+    int shipLengths[] = {5, 4, 3, 2}; // Carrier, Battleship, Submarine, Patrol Boat
+    for (int shipIndex = 0; shipIndex < 4; shipIndex++) {
+        char shipCell = '0' + shipLengths[shipIndex];
+        fleet[shipIndex] = 0;
+        for (int cellIndex = 0; cellIndex < GRID_SIZE * GRID_SIZE; cellIndex++) { // find the first cell of this ship (hit or not)
+            int row = cellIndex / GRID_SIZE;
+            int col = cellIndex % GRID_SIZE;
+            if (grid[row][col] == shipCell || grid[row][col] == shipCell + 10) {
+                int horizontal = col + 1 < GRID_SIZE && (grid[row][col + 1] == shipCell || grid[row][col + 1] == shipCell + 10);
+                fleet[shipIndex] = (unsigned char)(cellIndex * 2 + (horizontal ? 0 : 1));
+                break;
+            }
+        }
+    }
+}
+
+/*
+Purpose: Rebuild the ships of a grid from the snapshot fleet format.
+Parameters: const unsigned char fleet[4] - the packed ships (Carrier, Battleship, Submarine, Patrol Boat).
+            char grid[GRID_SIZE][GRID_SIZE] - the (empty) grid to place the ships on.
+Return: 1 if every ship was placed, 0 if the fleet is invalid.
+Side Effects: Modifies the grid parameter.
+*/
+int unpackFleet(const unsigned char fleet[4], char grid[GRID_SIZE][GRID_SIZE]) {
+    int shipLengths[] = {5, 4, 3, 2}; // Carrier, Battleship, Submarine, Patrol Boat
+    for (int shipIndex = 0; shipIndex < 4; shipIndex++) {
+        int cellIndex = fleet[shipIndex] / 2;
+        char shipOrientation = (fleet[shipIndex] % 2) ? 'V' : 'H';
+        if (cellIndex >= GRID_SIZE * GRID_SIZE || !isPlacementValid(cellIndex / GRID_SIZE, cellIndex % GRID_SIZE, shipLengths[shipIndex], shipOrientation, grid)) {
+            return 0;
+        }
+        placeShip(cellIndex / GRID_SIZE, cellIndex % GRID_SIZE, shipLengths[shipIndex], shipOrientation, grid);
+    }
+    return 1;
+}
 
-    *sunkShipCount = sunkCount; // Update the sunk ship count
+/*
+Purpose: Pack the cells of a grid that have been fired at into a bitmask (bit n is cell n, in row order).
+Parameters: char grid[GRID_SIZE][GRID_SIZE] - the grid to read.
+            unsigned char shots[SHOT_MASK_BYTES] - an array to store the bitmask.
+Return: None
+Side Effects: Modifies the shots array.
+*/
+void packShots(char grid[GRID_SIZE][GRID_SIZE], unsigned char shots[SHOT_MASK_BYTES]) {
+    memset(shots, 0, SHOT_MASK_BYTES);
+    for (int cellIndex = 0; cellIndex < GRID_SIZE * GRID_SIZE; cellIndex++) {
+        if (!isCellUnshot(grid, cellIndex / GRID_SIZE, cellIndex % GRID_SIZE)) {
+            shots[cellIndex / 8] |= (unsigned char)(1 << (cellIndex % 8));
+        }
+    }
+}
+
+/*
+Purpose: Replay a shot bitmask onto a grid that already holds its ships, marking each shot cell as a hit or a miss.
+Parameters: const unsigned char shots[SHOT_MASK_BYTES] - the shot bitmask.
+            char grid[GRID_SIZE][GRID_SIZE] - the grid that was fired at.
+            char viewGrid[GRID_SIZE][GRID_SIZE] - the shooter's view of that grid (NULL if there is none).
+Return: None
+Side Effects: Modifies the grid and viewGrid parameters.
+*/
+void unpackShots(const unsigned char shots[SHOT_MASK_BYTES], char grid[GRID_SIZE][GRID_SIZE], char viewGrid[GRID_SIZE][GRID_SIZE]) {
+    for (int cellIndex = 0; cellIndex < GRID_SIZE * GRID_SIZE; cellIndex++) {
+        int row = cellIndex / GRID_SIZE;
+        int col = cellIndex % GRID_SIZE;
+        if (!(shots[cellIndex / 8] & (1 << (cellIndex % 8)))) { // if this cell was never fired at, leave it alone
+            continue;
+        }
+        if (grid[row][col] >= '2' && grid[row][col] <= '5') { // if there is a ship here, mark it as hit
+            grid[row][col] += 10;
+            if (viewGrid != NULL) {
+                viewGrid[row][col] = HIT_CELL;
+            }
+        } else {
+            grid[row][col] = MISS_CELL;
+            if (viewGrid != NULL) {
+                viewGrid[row][col] = MISS_CELL;
+            }
+        }
+    }
+}
+
+/*
+Purpose: Count the hits and misses marked on a grid.
+Parameters: char grid[GRID_SIZE][GRID_SIZE] - the grid that was fired at.
+            int* hitCount - a pointer to store the number of ship cells that were hit.
+            int* missCount - a pointer to store the number of misses.
+Return: None
+Side Effects: Modifies the hitCount and missCount parameters.
+*/
+void countShots(char grid[GRID_SIZE][GRID_SIZE], int* hitCount, int* missCount) {
+    *hitCount = 0;
+    *missCount = 0;
+    for (int cellIndex = 0; cellIndex < GRID_SIZE * GRID_SIZE; cellIndex++) {
+        char cell = grid[cellIndex / GRID_SIZE][cellIndex % GRID_SIZE];
+        if (cell >= '2' + 10 && cell <= '5' + 10) {
+            (*hitCount)++;
+        } else if (cell == MISS_CELL) {
+            (*missCount)++;
+        }
+    }
+}
+
+/*
+Purpose: Save the full state of the game in progress into a snapshot record.
+Parameters: GameSnapshot* snapshot - a pointer to the snapshot to fill in.
+Return: None
+Side Effects: Modifies the snapshot parameter.
+*/
+void saveSnapshot(GameSnapshot* snapshot) {
+    memset(snapshot, 0, sizeof(GameSnapshot));
+    snapshot->magic[0] = 'B';
+    snapshot->magic[1] = 'S';
+    snapshot->version = SNAPSHOT_VERSION;
+    snapshot->salvoMode = (unsigned char)salvoMode;
+    packFleet(playerGrid, snapshot->playerFleet);
+    packFleet(enemyGrid, snapshot->enemyFleet);
+    packShots(enemyGrid, snapshot->playerShots);
+    packShots(playerGrid, snapshot->enemyShots);
+    snapshot->playerHits = (unsigned char)playerHits; // every counter is at most GRID_SIZE * GRID_SIZE, so it fits in a byte
+    snapshot->playerMisses = (unsigned char)playerMisses;
+    snapshot->enemyHits = (unsigned char)enemyHits;
+    snapshot->enemyMisses = (unsigned char)enemyMisses;
+    if (lastHitXCoordinate != GRID_SIZE && lastHitYCoordinate != GRID_SIZE) {
+        snapshot->lastHitCell = (unsigned char)(lastHitXCoordinate * GRID_SIZE + lastHitYCoordinate);
+    } else {
+        snapshot->lastHitCell = SNAPSHOT_NO_LAST_HIT;
+    }
+    for (int byteIndex = 0; byteIndex < 4; byteIndex++) { // store the generator state little-endian
+        snapshot->randomState[byteIndex] = (unsigned char)(randomState >> (8 * byteIndex));
+    }
+    snapshot->enemyMovesPlayed = (unsigned char)enemyMovesPlayed;
+    snapshot->enemyMovesOverBudget = (unsigned char)enemyMovesOverBudget;
+    uint32_t thinkingTime = enemyThinkingMicroseconds > UINT32_MAX ? UINT32_MAX : (uint32_t)enemyThinkingMicroseconds;
+    for (int byteIndex = 0; byteIndex < 4; byteIndex++) {
+        snapshot->enemyThinkingMicroseconds[byteIndex] = (unsigned char)(thinkingTime >> (8 * byteIndex));
+    }
+}
+
+/*
+Purpose: Restore a game in progress from a snapshot record.
+Parameters: const GameSnapshot* snapshot - a pointer to the snapshot to restore.
+Return: 1 if the game was restored, 0 if the snapshot is invalid (the game is left freshly initialized). A snapshot is invalid
+if its fleets overlap, its hit and miss counts do not match its shots, or either fleet is already sunk (finished games are never saved).
+Side Effects: Modifies all of the game's global variables.
+*/
+int loadSnapshot(const GameSnapshot* snapshot) {
+    uint32_t restoredState = 0;
+    uint32_t thinkingTime = 0;
+    int shotHits = 0;
+    int shotMisses = 0;
+    initializeGame();
+    if (snapshot->magic[0] != 'B' || snapshot->magic[1] != 'S' || snapshot->version != SNAPSHOT_VERSION) {
+        return 0;
+    }
+    if (!unpackFleet(snapshot->playerFleet, playerGrid) || !unpackFleet(snapshot->enemyFleet, enemyGrid)) {
+        initializeGame();
+        return 0;
+    }
+    unpackShots(snapshot->playerShots, enemyGrid, playerViewOfEnemyGrid);
+    unpackShots(snapshot->enemyShots, playerGrid, NULL);
+    countShots(enemyGrid, &shotHits, &shotMisses); // the stored counters must agree with the shots they summarize
+    if (shotHits != snapshot->playerHits || shotMisses != snapshot->playerMisses) {
+        initializeGame();
+        return 0;
+    }
+    countShots(playerGrid, &shotHits, &shotMisses);
+    if (shotHits != snapshot->enemyHits || shotMisses != snapshot->enemyMisses) {
+        initializeGame();
+        return 0;
+    }
+    playerSunkShips = countSunkShips(playerGrid, playerShipsAnnounced); // ships sunk before the save were already announced
+    enemySunkShips = countSunkShips(enemyGrid, enemyShipsAnnounced);
+    if (playerSunkShips == 4 || enemySunkShips == 4) {
+        initializeGame();
+        return 0;
+    }
+    salvoMode = snapshot->salvoMode ? 1 : 0;
+    playerHits = snapshot->playerHits;
+    playerMisses = snapshot->playerMisses;
+    enemyHits = snapshot->enemyHits;
+    enemyMisses = snapshot->enemyMisses;
+    if (snapshot->lastHitCell < GRID_SIZE * GRID_SIZE) {
+        lastHitXCoordinate = snapshot->lastHitCell / GRID_SIZE;
+        lastHitYCoordinate = snapshot->lastHitCell % GRID_SIZE;
+    }
+    for (int byteIndex = 0; byteIndex < 4; byteIndex++) {
+        restoredState |= (uint32_t)snapshot->randomState[byteIndex] << (8 * byteIndex);
+    }
+    seedRandom(restoredState);
+    enemyMovesPlayed = snapshot->enemyMovesPlayed;
+    enemyMovesOverBudget = snapshot->enemyMovesOverBudget;
+    for (int byteIndex = 0; byteIndex < 4; byteIndex++) {
+        thinkingTime |= (uint32_t)snapshot->enemyThinkingMicroseconds[byteIndex] << (8 * byteIndex);
+    }
+    enemyThinkingMicroseconds = thinkingTime;
+    return 1;
+}
+
+/*
+Purpose: Save the game in progress to a snapshot file.
+Parameters: const char* fileName - the name of the file to write.
+Return: 1 if the file was written, 0 otherwise.
+Side Effects: Creates or overwrites the file.
+*/
+int writeSnapshotFile(const char* fileName) {
+    GameSnapshot snapshot;
+    FILE* snapshotFile = fopen(fileName, "wb");
+    if (snapshotFile == NULL) {
+        return 0;
+    }
+    saveSnapshot(&snapshot);
+    int written = fwrite(&snapshot, sizeof(snapshot), 1, snapshotFile) == 1;
+    if (fclose(snapshotFile) != 0) {
+        written = 0;
+    }
+    return written;
+}
+
+/*
+Purpose: Restore a game in progress from a snapshot file.
+Parameters: const char* fileName - the name of the file to read.
+Return: 1 if the game was restored, 0 if the file is missing or invalid.
+Side Effects: Modifies all of the game's global variables.
+*/
+int readSnapshotFile(const char* fileName) {
+    GameSnapshot snapshot;
+    FILE* snapshotFile = fopen(fileName, "rb");
+    if (snapshotFile == NULL) {
+        return 0;
+    }
+    int readOk = fread(&snapshot, sizeof(snapshot), 1, snapshotFile) == 1;
+    fclose(snapshotFile);
+    return readOk && loadSnapshot(&snapshot);
+}
+
+/*
+Purpose: Check if a snapshot file is present.
+Parameters: const char* fileName - the name of the file to look for.
+Return: 1 if the file can be opened, 0 otherwise.
+Side Effects: None
+*/
+int snapshotFileExists(const char* fileName) {
+    FILE* snapshotFile = fopen(fileName, "rb");
+    if (snapshotFile == NULL) {
+        return 0;
+    }
+    fclose(snapshotFile);
+    return 1;
+}
+
+/*
+Purpose: Save the game to SNAPSHOT_FILE_NAME when the player asks to quit in the middle of a game.
+Parameters: None
+Return: 1 if the game was saved, 0 if it could not be saved (the game carries on).
+Side Effects: Modifies the global variable gameSaved.
+*/
+int saveGameAndQuit() {
+    if (!writeSnapshotFile(SNAPSHOT_FILE_NAME)) {
+        printf("\nSorry, the game could not be saved. Let's keep playing.\n");
+        return 0;
+    }
+    printf("\nYour game has been saved. Come back any time to finish it!\n");
+    gameSaved = 1;
+    return 1;
 }
 
 /*-----------------------------------Main Function-----------------------------------*/
 /*
 Purpose: The main function of the program. The main function will call all the other functions to run the game.
-Parameters: None
+Parameters: int argc, char* argv[] - the command line options (--selftest checks the heatmap kernels, --bench times them,
+            --batch uses the bulk simulation time budget, --budget <microseconds> sets the enemy's time budget per move).
 Returns: 0 (indicates that the program ran successfully and ends).
 Side Effects: None
 */
-int main() { 
+int main(int argc, char* argv[]) { 
     // Variable declarations
 /*--------------------------------------------*/
     // Char/character variables
     char playerName[MAX_NAME_LENGTH] = {0}; 
     char playerAgreement = 'N';
     char playAgainChoice = 'N';
+    char gameModeChoice[MAX_NAME_LENGTH] = {0};
+    char resumeChoice[MAX_NAME_LENGTH] = {0};
+    int resumedGame = 0;
+    /*--------------------------------------------*/
+    seedRandom((uint32_t)time(NULL)); // Moved here to be called only once
+    initHeatmapKernel(); // Picks the heatmap kernel for this CPU and builds the ship placement table
     /*--------------------------------------------*/
-    srand(time(NULL)); // Moved here to be called only once
+    for (int argIndex = 1; argIndex < argc; argIndex++) { // Handles the command line options
+        if (strcmp(argv[argIndex], "--selftest") == 0) {
+            return runHeatmapSelfTest();
+        } else if (strcmp(argv[argIndex], "--bench") == 0) {
+            runHeatmapBenchmark();
+            return 0;
+        } else if (strcmp(argv[argIndex], "--batch") == 0) {
+            setMoveBudget(BATCH_MOVE_BUDGET_US);
+        } else if (strcmp(argv[argIndex], "--budget") == 0 && argIndex + 1 < argc) {
+            long long budgetMicroseconds = 0;
+            argIndex++;
+            if (!parseMoveBudget(argv[argIndex], &budgetMicroseconds)) {
+                printf("Invalid budget '%s'. --budget takes a whole number of microseconds, for example --budget 50\n", argv[argIndex]);
+                printf("Options: --selftest, --bench, --batch, --budget <microseconds>\n");
+                return 1;
+            }
+            setMoveBudget(budgetMicroseconds);
+        } else {
+            printf("Unknown option '%s'. Options: --selftest, --bench, --batch, --budget <microseconds>\n", argv[argIndex]);
+            return 1;
+        }
+    }
     /*--------------------------------------------*/
     void printMessage(); // Calls the printMessage function to print the welcome message
     /*--------------------------------------------*/
@@ -696,11 +1869,34 @@ int main() {
     /*--------------------------------------------*/
     if (playerAgreement == 'Y' || playerAgreement == 'y') { // If the user puts 'Y' for agreement, the game will start
         do {
-            initializeGame(); // Calls the initializeGame function to initialize the game
-            placePlayerShips(); // Calls the placePlayerShips function to place the player's ships
-            placeEnemyShips(); // Calls the placeEnemyShips function to place the enemy's ships
+            resumedGame = 0;
+            if (snapshotFileExists(SNAPSHOT_FILE_NAME)) { // If a game was parked earlier, offer to pick it back up
+                getValidInput("\nA saved game was found. Would you like to resume it? (Y/N): ", resumeChoice, isValidAgreement);
+                if (*resumeChoice == 'Y' || *resumeChoice == 'y') {
+                    resumedGame = readSnapshotFile(SNAPSHOT_FILE_NAME); // Restores the whole game state from the snapshot
+                    if (!resumedGame) {
+                        printf("\nSorry, the saved game could not be loaded. Starting a new game instead.\n");
+                        remove(SNAPSHOT_FILE_NAME); // A damaged save would fail the same way every time, so it should not be offered again
+                    }
+                }
+            }
+            if (!resumedGame) {
+                getGameMode(gameModeChoice); // Calls the getGameMode function to pick between Classic and Salvo
+                initializeGame(); // Calls the initializeGame function to initialize the game
+                placePlayerShips(); // Calls the placePlayerShips function to place the player's ships
+                placeEnemyShips(); // Calls the placeEnemyShips function to place the enemy's ships
+            }
             printBoard(playerGrid, "Your Board"); // Calls the printBoard function to print the player's board
+            if (resumedGame) {
+                printBoard(playerViewOfEnemyGrid, "Enemy Board"); // Shows the shots already fired before the game was saved
+            }
             gameLoop(); // Calls the gameLoop function to start the game
+            if (gameSaved) { // The player saved and quit, so leave without asking to play again
+                break;
+            }
+            if (resumedGame) {
+                remove(SNAPSHOT_FILE_NAME); // The saved game is finished, so it should not be offered again
+            }
             displayStatistics(); // Calls the displayStatistics function to display the game statistics
             playAgain(&playAgainChoice); // Calls the PlayAgain function to prompt the user if they would like to play again
         } while (playAgainChoice == 'Y' || playAgainChoice == 'y');
@@ -10,6 +10,35 @@ int isValidCoordinate(int xCoordinate, int yCoordinate);
 int isPlacementValid(int xCoordinate, int yCoordinate, int shipLength, char shipOrientation, char grid[GRID_SIZE][GRID_SIZE]);
 void placeShip(int xCoordinate, int yCoordinate, int shipLength, char shipOrientation, char grid[GRID_SIZE][GRID_SIZE]);
 void printBoard(char grid[GRID_SIZE][GRID_SIZE], const char* boardTitle);
-void hitAndSunkShips(char grid[GRID_SIZE][GRID_SIZE], int* sunkShipCount);
+void hitAndSunkShips(char grid[GRID_SIZE][GRID_SIZE], int* sunkShipCount, int shipAnnounced[4], int enemyFiring);
+int countSunkShips(char grid[GRID_SIZE][GRID_SIZE], int shipSunk[4]);
+int isValidGameMode(const char* gameModeChoice);
+int isCellUnshot(char grid[GRID_SIZE][GRID_SIZE], int xCoordinate, int yCoordinate);
+int resolveVolley(char grid[GRID_SIZE][GRID_SIZE], char viewGrid[GRID_SIZE][GRID_SIZE], const int volleyX[], const int volleyY[], int shotCount, int* hitCount, int* missCount, int* sunkShipCount, int enemyVolley);
+int selectEnemyVolley(int volleyX[], int volleyY[], int shotCount, long long deadline, int* budgetHit);
+void playerSalvoTurn();
+void enemySalvoTurn();
+void seedRandom(uint32_t seed);
+int gameRandom();
+int getAttackCoordinate(const char* prompt);
+int saveGameAndQuit();
+void countShots(char grid[GRID_SIZE][GRID_SIZE], int* hitCount, int* missCount);
+void saveSnapshot(GameSnapshot* snapshot);
+int loadSnapshot(const GameSnapshot* snapshot);
+int writeSnapshotFile(const char* fileName);
+int readSnapshotFile(const char* fileName);
+int snapshotFileExists(const char* fileName);
+void buildPlacementTable();
+void accumulateHeatmapScalar(const CellMask* placements, int count, uint16_t counters[HEATMAP_CELLS]);
+void initHeatmapKernel();
+int heatmapArgmax(const uint16_t counters[HEATMAP_CELLS], const CellMask* candidates, int startCell);
+int selectHeatmapTargets(int targetX[], int targetY[], int targetCount, char excluded[GRID_SIZE][GRID_SIZE], long long deadline, int* budgetHit);
+long long currentMicroseconds();
+void recordEnemyMove(long long startTime, int budgetHit);
+int listHeatmapKernels(HeatmapKernel kernels[HEATMAP_KERNEL_COUNT], const char* kernelNames[HEATMAP_KERNEL_COUNT]);
+int runHeatmapSelfTest();
+void runHeatmapBenchmark();
+void setMoveBudget(long long budgetMicroseconds);
+int parseMoveBudget(const char* budgetText, long long* budgetMicroseconds);
 
 
@@ -6,6 +6,55 @@
 #define MISS_CELL 'O' // Variable to store the character value of the miss cell
 #define SHIP_CELL 'S' // Dedicated constant for ship cells
 #define DEBUG 0 // Set to 1 to enable the debug flags within my program 
+#define MAX_SALVO_SHOTS 4 // Variable to store the maximum number of shots in a salvo volley (one per surviving ship)
+#define SAVE_AND_QUIT -1 // Coordinate value returned when the player asks to save and quit instead of attacking
+#define SNAPSHOT_FILE_NAME "battleship_save.bin" // File used to park an in-progress game
+#define SNAPSHOT_VERSION 3 // Bump whenever the layout of GameSnapshot changes
+#define SNAPSHOT_NO_LAST_HIT 0xFF // Stored in lastHitCell when the enemy has no last hit to aim around
+#define SHOT_MASK_BYTES ((GRID_SIZE * GRID_SIZE + 7) / 8) // One bit per cell of a grid
+#define MAX_PLACEMENTS (4 * 2 * GRID_SIZE * GRID_SIZE) // Upper bound on the number of ship placements (4 ships, 2 orientations)
+#define HEATMAP_SSE2_CHUNKS ((GRID_SIZE * GRID_SIZE + 7) / 8) // Number of 8-cell vectors the SSE2 heatmap kernel works on
+#define HEATMAP_AVX2_CHUNKS ((GRID_SIZE * GRID_SIZE + 15) / 16) // Number of 16-cell vectors the AVX2 heatmap kernel works on
+#define HEATMAP_CELLS (HEATMAP_AVX2_CHUNKS * 16) // Heatmap counters, padded so the SIMD kernels always work on whole vectors
+#define HEATMAP_SLICE 256 // Placements checked and added to the heatmap between deadline checks (also sizes the per-slice buffer)
+#define INTERACTIVE_MOVE_BUDGET_US 100000 // Enemy time budget per move when playing in the terminal (100 milliseconds)
+#define BATCH_MOVE_BUDGET_US 50 // Enemy time budget per move when simulating games in bulk (50 microseconds)
+#define HEATMAP_KERNEL_COUNT 3 // Number of heatmap kernels (scalar, SSE2, AVX2)
+#define HEATMAP_SELFTEST_TRIALS 20000 // Random trials checked by --selftest
+#define HEATMAP_SELFTEST_CALLS 4 // Most kernel calls chained on the same counters in one --selftest trial
+#define HEATMAP_SELFTEST_MAX_START 60000 // Starting counters are below this, leaving room for a few full placement tables
+#define HEATMAP_BENCH_RUNS 100000 // Runs timed per kernel by --bench
+#define HEATMAP_EIGHTS_PLANES 8 // Bit planes the SIMD heatmap kernels use to count batches of 8 (enough for 2040 placements)
+
+
+// Snapshot of an in-progress game (53 bytes). Every field is a single byte (multi-byte values are stored little-endian),
+// so the record has no padding, reads the same on every machine, and can be stored back to back in an array or file.
+typedef struct {
+    unsigned char magic[2]; // 'B', 'S'
+    unsigned char version; // SNAPSHOT_VERSION
+    unsigned char salvoMode; // 1 for Salvo, 0 for Classic
+    unsigned char playerFleet[4]; // Carrier, Battleship, Submarine, Patrol Boat: (cell index * 2) + 1 if vertical
+    unsigned char enemyFleet[4]; // Same packing as playerFleet
+    unsigned char playerShots[SHOT_MASK_BYTES]; // Cells of the enemy grid the player has fired at
+    unsigned char enemyShots[SHOT_MASK_BYTES]; // Cells of the player grid the enemy has fired at
+    unsigned char playerHits; // Must match playerShots (sunk ship counts are not stored, they are worked out from the grids)
+    unsigned char playerMisses;
+    unsigned char enemyHits; // Must match enemyShots
+    unsigned char enemyMisses;
+    unsigned char lastHitCell; // Cell index of the enemy's last hit, or SNAPSHOT_NO_LAST_HIT
+    unsigned char randomState[4]; // State of the game's random number generator
+    unsigned char enemyMovesPlayed; // Enemy timing statistics (each enemy move fires at least one shot, so the move counts fit in a byte)
+    unsigned char enemyMovesOverBudget;
+    unsigned char enemyThinkingMicroseconds[4]; // Capped at UINT32_MAX (about 71 minutes)
+} GameSnapshot;
+
+// Bitmask with one bit per cell of a grid (bit n of the mask is cell n in row order, cells 0-63 in bits[0] and the rest in bits[1])
+typedef struct {
+    uint64_t bits[2];
+} CellMask;
+
+// Heatmap kernel: adds each placement mask into the per-cell counters
+typedef void (*HeatmapKernel)(const CellMask* placements, int count, uint16_t counters[HEATMAP_CELLS]);
 
 
 // Global Variables
@@ -18,5 +67,19 @@ int playerSunkShips = 0; // Variable to store the integer value of the player su
 int enemyHits = 0; // Variable to store the integer value of the enemy hits
 int enemyMisses = 0; // Variable to store the integer value of the enemy misses
 int enemySunkShips = 0; // Variable to store the integer value of the enemy sunk ships
+int playerShipsAnnounced[4] = {0, 0, 0, 0}; // Player ships (Carrier, Battleship, Submarine, Patrol Boat) whose sinking has been announced
+int enemyShipsAnnounced[4] = {0, 0, 0, 0}; // Enemy ships (Carrier, Battleship, Submarine, Patrol Boat) whose sinking has been announced
 int lastHitXCoordinate = GRID_SIZE; // Track the last hit coordinates for the X axis, set to GRID_SIZE because it is out of valid range
-int lastHitYCoordinate = GRID_SIZE; // Track the last hit coordinates for the Y axis, set to GRID_SIZE because it is out of valid range
\ No newline at end of file
+int lastHitYCoordinate = GRID_SIZE; // Track the last hit coordinates for the Y axis, set to GRID_SIZE because it is out of valid range
+int salvoMode = 0; // Set to 1 when the player picks the Salvo game mode (one shot per surviving ship each turn)
+int gameSaved = 0; // Set to 1 once the player has saved the game and asked to quit
+uint32_t randomState = 1; // State of the game's random number generator (never 0)
+CellMask placementMasks[MAX_PLACEMENTS]; // Every possible placement of every ship on an empty board
+int placementShips[MAX_PLACEMENTS]; // Ship index (Carrier, Battleship, Submarine, Patrol Boat) of each placement
+int placementCount = 0; // Number of entries in placementMasks
+HeatmapKernel accumulateHeatmap = NULL; // Heatmap kernel picked for this CPU
+const char* heatmapKernelName = "scalar"; // Name of the heatmap kernel picked for this CPU
+long long moveBudgetMicroseconds = INTERACTIVE_MOVE_BUDGET_US; // Time the enemy may spend picking each move (set with --batch or --budget)
+long enemyMovesPlayed = 0; // Number of moves the enemy has picked this game
+long enemyMovesOverBudget = 0; // Number of those moves that ran into the time budget and used their best result so far
+long long enemyThinkingMicroseconds = 0; // Total time the enemy has spent picking moves this game
\ No newline at end of file